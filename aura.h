@@ -282,10 +282,146 @@ typedef struct aura_chord {
 
 
 
+/* PROFILING *****************************
+ * Define AURA_PROFILE to count calls and cycles spent in the public entry points.
+ *  - Counters are per-thread: each thread resets only its own; for a process-wide
+ *    summary, have each thread aura_ProfileAccumulate into a shared total (under
+ *    the caller's lock) before it exits, then aura_ProfileDump that total
+ *  - Cycles are inclusive (e.g. aura_RNADiatonicChord includes its aura_5thsOffset call)
+ *  - Without AURA_PROFILE, AURA_PROFILE_BEGIN/END expand to nothing
+ *  - To profile a new entry point, add it to AURA_PROFILED_FNS and wrap its body
+ *    in AURA_PROFILE_BEGIN(fn) (with the declarations) ... AURA_PROFILE_END(fn) (before the return)
+ */
+#ifdef AURA_PROFILE
+#include <stdio.h>
+
+/* NOTE: off x86 these are timer ticks (cntvct/ns) rather than cycles,
+ * but still fine for relative cost */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AURA_THREAD_LOCAL __declspec(thread)
+#if defined(_M_X64) || defined(_M_IX86)
+#define AURA_PROFILE_CYCLES() __rdtsc()
+#elif defined(_M_ARM64)
+#define AURA_PROFILE_CYCLES() ((unsigned long long)_ReadStatusReg(ARM64_CNTVCT))
+#endif
+#else
+#define AURA_THREAD_LOCAL __thread
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define AURA_PROFILE_CYCLES() __rdtsc()
+#elif defined(__aarch64__)
+unsigned long long
+aura_ProfileCycles_(void) {
+	unsigned long long Result;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(Result));
+	return Result;
+}
+#define AURA_PROFILE_CYCLES() aura_ProfileCycles_()
+#endif
+#endif
+
+/* NOTE: CLOCK_MONOTONIC is only visible with POSIX (e.g. _POSIX_C_SOURCE 199309L);
+ * without it (or off POSIX) this falls back to the much coarser clock() */
+#ifndef AURA_PROFILE_CYCLES
+#include <time.h>
+#ifdef CLOCK_MONOTONIC
+unsigned long long
+aura_ProfileCycles_(void) {
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (unsigned long long)Now.tv_sec * 1000000000ull + (unsigned long long)Now.tv_nsec;
+}
+#define AURA_PROFILE_CYCLES() aura_ProfileCycles_()
+#else
+#define AURA_PROFILE_CYCLES() ((unsigned long long)clock())
+#endif
+#endif
+
+#define AURA_PROFILED_FNS \
+	AURA_PROFILED_FN(auraNote) \
+	AURA_PROFILED_FN(aura_5thsOffset) \
+	AURA_PROFILED_FN(aura_5thDist) \
+	AURA_PROFILED_FN(aura_RNADiatonicChord) \
+	AURA_PROFILED_FN(aura_ProgressionDist) \
+	AURA_PROFILED_FN(aura_ProgressionIndexBuild) \
+	AURA_PROFILED_FN(aura_ProgressionIndexOpen) \
+	AURA_PROFILED_FN(aura_ProgressionIndexValidate) \
+	AURA_PROFILED_FN(aura_ProgressionIndexNearest) \
+	AURA_PROFILED_FN(aura_LatticeFromNotes) \
+	AURA_PROFILED_FN(aura_LatticeToNotes) \
+	AURA_PROFILED_FN(aura_LatticeFromChords) \
+	AURA_PROFILED_FN(aura_LatticeToChords) \
+	AURA_PROFILED_FN(aura_LatticeTranslate) \
+	AURA_PROFILED_FN(aura_LatticeDists) \
+
+#define AURA_PROFILED_FN_DECORATE(x) AURA_PROF_## x
+#define AURA_PROFILED_FN(x) AURA_PROFILED_FN_DECORATE(x),
+typedef enum aura_profiled_fn { AURA_PROFILED_FNS AURA_PROFILED_FN_DECORATE(Count) } aura_profiled_fn;
+#undef AURA_PROFILED_FN
+
+#define AURA_PROFILED_FN(x) #x,
+char *auraProfiledFnStrings[] = { AURA_PROFILED_FNS };
+#undef AURA_PROFILED_FN
+
+typedef struct aura_profile_counter {
+	unsigned long long Calls;
+	unsigned long long Cycles;
+} aura_profile_counter;
+
+AURA_THREAD_LOCAL aura_profile_counter auraProfileCounters[AURA_PROFILED_FN_DECORATE(Count)];
+
+/* NOTE: no trailing semicolons at the use site, so these vanish entirely when disabled */
+#define AURA_PROFILE_BEGIN(fn) unsigned long long AuraProfileStart_## fn = AURA_PROFILE_CYCLES();
+#define AURA_PROFILE_END(fn) \
+	auraProfileCounters[AURA_PROFILED_FN_DECORATE(fn)].Cycles += AURA_PROFILE_CYCLES() - AuraProfileStart_## fn; \
+	++auraProfileCounters[AURA_PROFILED_FN_DECORATE(fn)].Calls;
+
+void
+aura_ProfileReset(void) {
+	int i;
+	for(i = 0; i < AURA_PROFILED_FN_DECORATE(Count); ++i) {
+		auraProfileCounters[i].Calls  = 0;
+		auraProfileCounters[i].Cycles = 0;
+	}
+}
+
+/* Adds this thread's counters into Total (AURA_PROF_Count entries).
+ * Not atomic: callers sharing a Total must serialise calls themselves. */
+void
+aura_ProfileAccumulate(aura_profile_counter *Total) {
+	int i;
+	for(i = 0; i < AURA_PROFILED_FN_DECORATE(Count); ++i) {
+		Total[i].Calls  += auraProfileCounters[i].Calls;
+		Total[i].Cycles += auraProfileCounters[i].Cycles;
+	}
+}
+
+/* CSV: a header row, then one `function,calls,cycles` row per profiled function.
+ * Counters is AURA_PROF_Count entries: auraProfileCounters for this thread,
+ * or a total built with aura_ProfileAccumulate. */
+void
+aura_ProfileDump(FILE *Out, aura_profile_counter *Counters) {
+	int i;
+	fprintf(Out, "function,calls,cycles\n");
+	for(i = 0; i < AURA_PROFILED_FN_DECORATE(Count); ++i) {
+		fprintf(Out, "%s,%llu,%llu\n", auraProfiledFnStrings[i],
+				Counters[i].Calls, Counters[i].Cycles);
+	}
+}
+#else
+#define AURA_PROFILE_BEGIN(fn)
+#define AURA_PROFILE_END(fn)
+#endif/* AURA_PROFILE */
+/*/PROFILING *****************************/
+
+
+
 aura_note auraNote(char *NoteName) {
 	/* TODO: ensure 2 chars exactly */
 	short NoteVal = *(short *)NoteName;
 	aura_note Result = AURA_NOTE_DECORATE(Error);
+	AURA_PROFILE_BEGIN(auraNote)
 	switch(NoteVal)
 	{
 		/* TODO: would these be better as a table of values? */
@@ -295,6 +431,7 @@ aura_note auraNote(char *NoteName) {
 		AURA_NOTES
 #undef AURA_NOTE
 	}
+	AURA_PROFILE_END(auraNote)
 	return Result;
 }
 
@@ -471,9 +608,11 @@ AURA_NOTE_MAP(aura_circle_of_5ths, 5th, FIFTH, 0);
 /* e.g. by interval, inver */
 aura_circle_of_5ths
 aura_5thsOffset(aura_circle_of_5ths Fifth, int Offset) {
+	AURA_PROFILE_BEGIN(aura_5thsOffset)
 	aura_circle_of_5ths Result = (Fifth < AU_5ths_Count)
 		? (Fifth + Offset) % AU_5ths_Count
 		: AU_5ths_Error;
+	AURA_PROFILE_END(aura_5thsOffset)
 	return Result;
 }
 
@@ -501,11 +640,13 @@ aura_circle_of_5ths aura_MinorThirdOf(aura_circle_of_5ths Note) { return aura_5t
 int
 aura_5thDist(aura_circle_of_5ths A, aura_circle_of_5ths B) {
 	int Result = AU_5ths_Error;
+	AURA_PROFILE_BEGIN(aura_5thDist)
 	if(A < AU_5ths_Count && B < AU_5ths_Count) {
 	 	Result = A-B;
 		if (Result < 0) { Result = -Result; }
 		if (Result > 6) { Result = AU_5ths_Count - Result; }
 	}
+	AURA_PROFILE_END(aura_5thDist)
 	return Result;
 }
 /* TODO (api fn): aura_5thDistCW ? */
@@ -527,6 +668,7 @@ typedef enum aura_scale_degree {
 aura_circle_of_5ths
 aura_RNADiatonicChord(aura_circle_of_5ths Chord, int Numeral, int MajorMinor)
 {
+	AURA_PROFILE_BEGIN(aura_RNADiatonicChord)
 	int Offsets[] = {/* if starting major: */
 		 0, /* major */
 		 2, /* minor */
@@ -537,10 +679,306 @@ aura_RNADiatonicChord(aura_circle_of_5ths Chord, int Numeral, int MajorMinor)
 	};
 	int Offset = MajorMinor * Offsets[Numeral - 1]; /* account for 1-based counting */
 	aura_circle_of_5ths Result = aura_5thsOffset(Chord, Offset);
+	AURA_PROFILE_END(aura_RNADiatonicChord)
 	return Result;
 }
 /*************************************/
 
+/* PROGRESSIONS **********************
+ * Each chord is its root on the circle of 5ths plus its kind (aura_chord Kind).
+ * Distance between progressions:
+ *  - per position: circle of 5ths distance of the roots (see aura_5thDist),
+ *    plus 1 if the kinds differ (so C-Am-F-G is 1 from C-A-F-G)
+ *  - summed over positions and minimised over all 12 transpositions,
+ *    so e.g. I-IV-V in C is distance 0 from I-IV-V in Eb
+ *  - each chord that one progression has and the other doesn't costs the max per-position distance (7)
+ * This is still a metric (for transposition-equivalent progressions), so it can be indexed
+ * with a vantage-point tree for nearest-neighbour search.
+ */
+#include <stddef.h>
+#include <string.h>
+
+#ifndef AURA_PROGRESSION_MAX
+#define AURA_PROGRESSION_MAX 16
+#endif
+
+#define AURA_PROGRESSION_KINDS (AURA_CHORD_Suspended2 + 1)
+/* 6 for roots at opposite sides of the circle, +1 for a different kind */
+#define AURA_PROGRESSION_CHORD_DIST_MAX 7
+
+/* NOTE: bytes rather than enums so the layout is fixed when serialised */
+typedef struct aura_progression {
+	unsigned char Count;
+	unsigned char Chords[AURA_PROGRESSION_MAX]; /* aura_circle_of_5ths; all < AU_5ths_Count */
+	unsigned char Kinds[AURA_PROGRESSION_MAX];  /* aura_chord Kind; all < AURA_PROGRESSION_KINDS */
+} aura_progression;
+
+/* Larger than any possible distance */
+#define AURA_PROGRESSION_DIST_MAX (AURA_PROGRESSION_CHORD_DIST_MAX * AURA_PROGRESSION_MAX + 1)
+
+int
+aura_ProgressionValid(aura_progression *Progression) {
+	int i, Result = (Progression->Count <= AURA_PROGRESSION_MAX);
+	for(i = 0; i < Progression->Count && Result; ++i) {
+		Result = (Progression->Chords[i] < AU_5ths_Count &&
+		          Progression->Kinds[i]  < AURA_PROGRESSION_KINDS);
+	}
+	return Result;
+}
+
+/* A and B should be aura_ProgressionValid; otherwise the result is meaningless,
+ * but Counts are clamped so it never reads past the progressions */
+int
+aura_ProgressionDist(aura_progression *A, aura_progression *B) {
+	int Transpose, i, Dist;
+	int CountA  = (A->Count < AURA_PROGRESSION_MAX) ? A->Count : AURA_PROGRESSION_MAX;
+	int CountB  = (B->Count < AURA_PROGRESSION_MAX) ? B->Count : AURA_PROGRESSION_MAX;
+	int Common  = (CountA < CountB) ? CountA : CountB;
+	int Missing = AURA_PROGRESSION_CHORD_DIST_MAX * ((CountA < CountB) ? CountB - CountA : CountA - CountB);
+	int Result  = AURA_PROGRESSION_DIST_MAX;
+	AURA_PROFILE_BEGIN(aura_ProgressionDist)
+	for(Transpose = 0; Transpose < AU_5ths_Count && Result > Missing; ++Transpose) {
+		for(i = 0, Dist = Missing; i < Common && Dist < Result; ++i) {
+			/* inline aura_5thDist - this is the inner loop of every search */
+			int Step = (A->Chords[i] - B->Chords[i] - Transpose + 2 * AU_5ths_Count) % AU_5ths_Count;
+			Dist += (Step > 6) ? AU_5ths_Count - Step : Step;
+			Dist += (A->Kinds[i] != B->Kinds[i]);
+		}
+		if(Dist < Result) { Result = Dist; }
+	}
+	AURA_PROFILE_END(aura_ProgressionDist)
+	return Result;
+}
+
+/* PROGRESSION INDEX *****************
+ * Vantage-point tree stored as a single flat block: a header followed by Count nodes.
+ * There are no pointers, so the block can be written to a file as-is and later
+ * mmapped/read back and used directly with aura_ProgressionIndexOpen.
+ *
+ * The subtree over nodes [Lo, Hi) has its vantage point at Lo, then:
+ *  - inside:  [Lo+1, Mid) - all within Threshold of the vantage point
+ *  - outside: [Mid, Hi)   - all at least Threshold from the vantage point
+ *  where Mid = Lo + 1 + (Hi - Lo - 1) / 2, so the tree shape is implied by Count.
+ *************************************/
+#define AURA_PROGRESSION_INDEX_MAGIC   0x49505541 /* "AUPI" (little-endian) */
+#define AURA_PROGRESSION_INDEX_VERSION 2
+
+typedef struct aura_progression_index_header {
+	unsigned int Magic;
+	unsigned int Version;
+	unsigned int ProgressionMax; /* must match AURA_PROGRESSION_MAX */
+	unsigned int Count;
+} aura_progression_index_header;
+
+typedef struct aura_progression_index_node {
+	int Id;        /* position in the library the index was built from */
+	int Threshold;
+	aura_progression Progression;
+} aura_progression_index_node;
+
+typedef struct aura_progression_index {
+	aura_progression_index_header *Header;
+	aura_progression_index_node   *Nodes;
+} aura_progression_index;
+
+size_t
+aura_ProgressionIndexSize(int Count)
+{ return sizeof(aura_progression_index_header) + Count * sizeof(aura_progression_index_node); }
+
+/* Overflow-safe check that Count nodes (+ header) fit in MemorySize */
+int
+aura_ProgressionIndexFits_(size_t MemorySize, size_t Count) {
+	return (MemorySize >= sizeof(aura_progression_index_header) &&
+	        Count <= (MemorySize - sizeof(aura_progression_index_header)) / sizeof(aura_progression_index_node));
+}
+
+#define AURA_PROGRESSION_INDEX_MID(lo, hi) ((lo) + 1 + ((hi) - (lo) - 1) / 2)
+
+/* NOTE: memcpy rather than struct assignment, so padding bytes are carried along
+ * and the built block is byte-for-byte reproducible */
+void
+aura_ProgressionIndexSwap_(aura_progression_index_node *A, aura_progression_index_node *B) {
+	aura_progression_index_node Tmp;
+	memcpy(&Tmp, A, sizeof(Tmp));
+	memcpy(A, B, sizeof(Tmp));
+	memcpy(B, &Tmp, sizeof(Tmp));
+}
+
+/* Partial sort on Threshold so that Nodes[K] is in its sorted position.
+ * 3-way partition, as integer distances have a lot of ties. */
+void
+aura_ProgressionIndexSelect_(aura_progression_index_node *Nodes, int Lo, int Hi, int K) {
+	while(Hi - Lo > 1) {
+		int Pivot = Nodes[Lo + (Hi - Lo) / 2].Threshold;
+		int Lt = Lo, i = Lo, Gt = Hi;
+		while(i < Gt) {
+			if     (Nodes[i].Threshold < Pivot) { aura_ProgressionIndexSwap_(&Nodes[i++], &Nodes[Lt++]); }
+			else if(Nodes[i].Threshold > Pivot) { aura_ProgressionIndexSwap_(&Nodes[i],   &Nodes[--Gt]); }
+			else                                { ++i; }
+		}
+		if     (K <  Lt) { Hi = Lt; }
+		else if(K >= Gt) { Lo = Gt; }
+		else             { break; }
+	}
+}
+
+/* NOTE: Threshold is used as scratch space for distances to the vantage point
+ * until that node becomes a vantage point itself */
+void
+aura_ProgressionIndexBuildRange_(aura_progression_index_node *Nodes, int Lo, int Hi) {
+	int i, Mid = AURA_PROGRESSION_INDEX_MID(Lo, Hi);
+	if(Hi - Lo > 1) {
+		for(i = Lo + 1; i < Hi; ++i) {
+			Nodes[i].Threshold = aura_ProgressionDist(&Nodes[Lo].Progression, &Nodes[i].Progression);
+		}
+		aura_ProgressionIndexSelect_(Nodes, Lo + 1, Hi, Mid);
+		Nodes[Lo].Threshold = Nodes[Mid].Threshold;
+		aura_ProgressionIndexBuildRange_(Nodes, Lo + 1, Mid);
+		aura_ProgressionIndexBuildRange_(Nodes, Mid, Hi);
+	}
+	else if(Hi - Lo == 1) { Nodes[Lo].Threshold = 0; }
+}
+
+/* Builds the index for Library into Memory, which must be int-aligned and
+ * at least aura_ProgressionIndexSize(Count) bytes.
+ * Returns 1 on success, 0 if Memory is too small or a progression is invalid
+ * (in which case neither Memory nor Index is touched).
+ * The node Ids are the progressions' positions in Library.
+ * The same Library always gives the same bytes (padding and unused chords are zeroed). */
+int
+aura_ProgressionIndexBuild(void *Memory, size_t MemorySize, aura_progression *Library, int Count,
+		aura_progression_index *Index)
+{
+	aura_progression_index_header *Header = (aura_progression_index_header *)Memory;
+	aura_progression_index_node   *Nodes  = (aura_progression_index_node *)(Header + 1);
+	int i, j, Result = (Count >= 0 && (size_t)Memory % sizeof(int) == 0 &&
+			aura_ProgressionIndexFits_(MemorySize, Count));
+	AURA_PROFILE_BEGIN(aura_ProgressionIndexBuild)
+	for(i = 0; i < Count && Result; ++i) { Result = aura_ProgressionValid(&Library[i]); }
+	if(Result) {
+		memset(Memory, 0, aura_ProgressionIndexSize(Count));
+		for(i = 0; i < Count; ++i) {
+			Nodes[i].Id                = i;
+			Nodes[i].Progression.Count = Library[i].Count;
+			for(j = 0; j < Library[i].Count; ++j) {
+				Nodes[i].Progression.Chords[j] = Library[i].Chords[j];
+				Nodes[i].Progression.Kinds[j]  = Library[i].Kinds[j];
+			}
+		}
+		Header->Magic          = AURA_PROGRESSION_INDEX_MAGIC;
+		Header->Version        = AURA_PROGRESSION_INDEX_VERSION;
+		Header->ProgressionMax = AURA_PROGRESSION_MAX;
+		Header->Count          = Count;
+		aura_ProgressionIndexBuildRange_(Nodes, 0, Count);
+		Index->Header = Header;
+		Index->Nodes  = Nodes;
+	}
+	AURA_PROFILE_END(aura_ProgressionIndexBuild)
+	return Result;
+}
+
+/* Uses an index already in memory (e.g. a mmapped file written from a built index's Memory).
+ * Memory must be int-aligned. Only the header and size are checked, so this is O(1) and
+ * doesn't touch the node pages; searching a corrupt index can give wrong answers but
+ * never reads outside the nodes. Use aura_ProgressionIndexValidate for untrusted files.
+ * Returns 1 on success, 0 if the memory doesn't hold a compatible index. */
+int
+aura_ProgressionIndexOpen(void *Memory, size_t MemorySize, aura_progression_index *Index) {
+	aura_progression_index_header *Header = (aura_progression_index_header *)Memory;
+	int Result = ((size_t)Memory % sizeof(int) == 0                      &&
+			MemorySize >= sizeof(*Header)                                &&
+			Header->Magic          == AURA_PROGRESSION_INDEX_MAGIC       &&
+			Header->Version        == AURA_PROGRESSION_INDEX_VERSION     &&
+			Header->ProgressionMax == AURA_PROGRESSION_MAX               &&
+			Header->Count          <= 0x7fffffff                         &&
+			aura_ProgressionIndexFits_(MemorySize, Header->Count));
+	AURA_PROFILE_BEGIN(aura_ProgressionIndexOpen)
+	if(Result) {
+		Index->Header = Header;
+		Index->Nodes  = (aura_progression_index_node *)(Header + 1);
+	}
+	AURA_PROFILE_END(aura_ProgressionIndexOpen)
+	return Result;
+}
+
+/* Checks every node of an opened index (O(Count), reads the whole file):
+ * Ids in [0, Count) and progressions aura_ProgressionValid.
+ * Returns 1 if the index is well-formed, 0 otherwise. */
+int
+aura_ProgressionIndexValidate(aura_progression_index *Index) {
+	unsigned int i;
+	int Result = 1;
+	AURA_PROFILE_BEGIN(aura_ProgressionIndexValidate)
+	for(i = 0; i < Index->Header->Count && Result; ++i) {
+		Result = (Index->Nodes[i].Id >= 0 && (unsigned int)Index->Nodes[i].Id < Index->Header->Count &&
+		          aura_ProgressionValid(&Index->Nodes[i].Progression));
+	}
+	AURA_PROFILE_END(aura_ProgressionIndexValidate)
+	return Result;
+}
+
+typedef struct aura_progression_search_ {
+	aura_progression *Query;
+	int K;
+	int Found;
+	int *Ids;   /* sorted nearest first */
+	int *Dists;
+} aura_progression_search_;
+
+void
+aura_ProgressionIndexSearch_(aura_progression_index_node *Nodes, int Lo, int Hi, aura_progression_search_ *Search) {
+	int i, Mid, Dist, Threshold, Tau;
+	if(Lo < Hi) {
+		Mid       = AURA_PROGRESSION_INDEX_MID(Lo, Hi);
+		Dist      = aura_ProgressionDist(Search->Query, &Nodes[Lo].Progression);
+		Threshold = Nodes[Lo].Threshold;
+
+		/* insert into the sorted results, dropping the furthest if full */
+		if(Search->Found < Search->K || Dist < Search->Dists[Search->K - 1]) {
+			i = (Search->Found < Search->K) ? Search->Found++ : Search->K - 1;
+			for(; i > 0 && Search->Dists[i - 1] > Dist; --i) {
+				Search->Ids[i]   = Search->Ids[i - 1];
+				Search->Dists[i] = Search->Dists[i - 1];
+			}
+			Search->Ids[i]   = Nodes[Lo].Id;
+			Search->Dists[i] = Dist;
+		}
+
+#define AURA_PROGRESSION_TAU (Search->Found < Search->K ? AURA_PROGRESSION_DIST_MAX : Search->Dists[Search->K - 1])
+		/* search the more likely side first so Tau shrinks before checking the other */
+		if(Dist < Threshold) {
+			aura_ProgressionIndexSearch_(Nodes, Lo + 1, Mid, Search);
+			Tau = AURA_PROGRESSION_TAU;
+			if(Dist + Tau >= Threshold) { aura_ProgressionIndexSearch_(Nodes, Mid, Hi, Search); }
+		}
+		else {
+			aura_ProgressionIndexSearch_(Nodes, Mid, Hi, Search);
+			Tau = AURA_PROGRESSION_TAU;
+			if(Dist - Tau <= Threshold) { aura_ProgressionIndexSearch_(Nodes, Lo + 1, Mid, Search); }
+		}
+#undef AURA_PROGRESSION_TAU
+	}
+}
+
+/* Finds the K progressions nearest to Query (in any transposition), nearest first.
+ * Ids and Dists must have room for K entries.
+ * Returns the number found: K, or fewer if the index is smaller than that;
+ * 0 if Query isn't aura_ProgressionValid. */
+int
+aura_ProgressionIndexNearest(aura_progression_index *Index, aura_progression *Query, int K, int *Ids, int *Dists) {
+	aura_progression_search_ Search;
+	AURA_PROFILE_BEGIN(aura_ProgressionIndexNearest)
+	Search.Query = Query;
+	Search.K     = K;
+	Search.Found = 0;
+	Search.Ids   = Ids;
+	Search.Dists = Dists;
+	if(K > 0 && aura_ProgressionValid(Query)) { aura_ProgressionIndexSearch_(Index->Nodes, 0, (int)Index->Header->Count, &Search); }
+	AURA_PROFILE_END(aura_ProgressionIndexNearest)
+	return Search.Found;
+}
+/*************************************/
+
 /* MODES *****************************/
 typedef enum aura_mode {
 /* Start point:
@@ -691,6 +1129,377 @@ AURA_NOTE_MAP(aura_harmonic_heptagon, HHEPT, HARMONIC_HEPT, AURA_HARMONIC_HEPT_D
 #undef AURA_NOTE
 /*************************************/
 
+/* TONNETZ LATTICE *******************
+ * Notes/intervals as integer points: Octaves*P8 + Fifths*P5 + Thirds*M3
+ *  - Semitone (1D):        12*Octaves + 7*Fifths + 4*Thirds
+ *  - Fifths + Thirds (2D): the Tonnetz; a minor third is (Fifths+1, Thirds-1)
+ *    (rather than the TODO's Tones + Semitones: a tone is just 2 semitones, so that
+ *    pair isn't independent, while fifths and thirds span the harmonic plane)
+ *  - + Octaves (3D):       register, e.g. for inversions/voicings
+ *  - Spelling is kept: the position on the line of 5ths is Fifths + 4*Thirds
+ * Transposition is adding a vector; inversion (about the origin) is negation.
+ *
+ * Packed as signed bytes in one 32-bit int: Fifths | Thirds << 8 | Octaves << 16
+ * so that vector add/sub are bytewise (4 points per SSE register).
+ * Each coordinate wraps outside [-128, 127].
+ * The top byte is 0 for valid points; add/sub/translate OR in the error bit of
+ * either operand, so AURA_LATTICE_Error propagates (even Error + Error).
+ *************************************/
+typedef unsigned int aura_lattice;
+
+#define AURA_LATTICE(o, f, t) ((aura_lattice)(unsigned char)(f)       | \
+                               (aura_lattice)(unsigned char)(t) <<  8 | \
+                               (aura_lattice)(unsigned char)(o) << 16)
+#define AURA_LATTICE_FIFTHS(l)  ((int)(signed char)( (l)        & 0xff))
+#define AURA_LATTICE_THIRDS(l)  ((int)(signed char)(((l) >>  8) & 0xff))
+#define AURA_LATTICE_OCTAVES(l) ((int)(signed char)(((l) >> 16) & 0xff))
+#define AURA_LATTICE_Error 0x80000000u
+
+#define AURA_LATTICE_HI 0x80808080u
+#define AURA_LATTICE_LO 0x7f7f7f7fu
+
+/* Spelled notes by position on the line of 5ths (C = 0, G = 1, F = -1...) */
+#define AURA_LINE_OF_5THS \
+	AURA_LINE_OF_5TH(Fb, -8) \
+	AURA_LINE_OF_5TH(Cb, -7) \
+	AURA_LINE_OF_5TH(Gb, -6) \
+	AURA_LINE_OF_5TH(Db, -5) \
+	AURA_LINE_OF_5TH(Ab, -4) \
+	AURA_LINE_OF_5TH(Eb, -3) \
+	AURA_LINE_OF_5TH(Bb, -2) \
+	AURA_LINE_OF_5TH(F,  -1) \
+	AURA_LINE_OF_5TH(C,   0) \
+	AURA_LINE_OF_5TH(G,   1) \
+	AURA_LINE_OF_5TH(D,   2) \
+	AURA_LINE_OF_5TH(A,   3) \
+	AURA_LINE_OF_5TH(E,   4) \
+	AURA_LINE_OF_5TH(B,   5) \
+	AURA_LINE_OF_5TH(Fs,  6) \
+	AURA_LINE_OF_5TH(Cs,  7) \
+	AURA_LINE_OF_5TH(Gs,  8) \
+	AURA_LINE_OF_5TH(Ds,  9) \
+	AURA_LINE_OF_5TH(As, 10) \
+	AURA_LINE_OF_5TH(Es, 11) \
+	AURA_LINE_OF_5TH(Bs, 12) \
+
+#define AURA_LINE_OF_5TH_DECORATE(x) AURA_LO5_## x
+#define AURA_LINE_OF_5TH(x, v) AURA_LINE_OF_5TH_DECORATE(x) = v,
+typedef enum aura_line_of_5ths {
+	AURA_LINE_OF_5THS
+
+	AURA_LINE_OF_5TH_DECORATE(Min) = -8,
+	AURA_LINE_OF_5TH_DECORATE(Max) = 12,
+} aura_line_of_5ths;
+#undef AURA_LINE_OF_5TH
+
+/* Canonical point for a line of 5ths position: Fifths in [-1, 2] (F C G D),
+ * the rest in Thirds, and Octaves so that the semitone value is in [0, 12) */
+#define AURA_LATTICE_CANON_FIFTHS(p)  (((p) + 17) % 4 - 1)
+#define AURA_LATTICE_CANON_THIRDS(p)  (((p) - AURA_LATTICE_CANON_FIFTHS(p)) / 4)
+#define AURA_LATTICE_CANON_OCTAVES(p) \
+	(2 - (7 * AURA_LATTICE_CANON_FIFTHS(p) + 4 * AURA_LATTICE_CANON_THIRDS(p) + 24) / 12)
+#define AURA_LATTICE_CANON(p) AURA_LATTICE(AURA_LATTICE_CANON_OCTAVES(p), \
+		AURA_LATTICE_CANON_FIFTHS(p), AURA_LATTICE_CANON_THIRDS(p))
+
+#define AURA_LINE_OF_5TH(x, v) AURA_NOTE_DECORATE(x),
+aura_note auraLineOf5thsToNote_[] = { AURA_LINE_OF_5THS };
+aura_note *auraLineOf5thsToNote = auraLineOf5thsToNote_ - AURA_LINE_OF_5TH_DECORATE(Min);
+#undef AURA_LINE_OF_5TH
+
+#define AURA_LINE_OF_5TH(x, v) AURA_LATTICE_CANON(v),
+aura_lattice auraLineOf5thsToLattice_[] = { AURA_LINE_OF_5THS };
+aura_lattice *auraLineOf5thsToLattice = auraLineOf5thsToLattice_ - AURA_LINE_OF_5TH_DECORATE(Min);
+#undef AURA_LINE_OF_5TH
+
+#define AURA_NOTE(x, s) AURA_LATTICE_CANON(AURA_LINE_OF_5TH_DECORATE(x)),
+aura_lattice auraNoteToLattice_[] = { AURA_LATTICE_Error, AURA_NOTES };
+aura_lattice *auraNoteToLattice = auraNoteToLattice_ + 1;
+#undef AURA_NOTE
+
+/* chord tones relative to the root, in chord order (root, 3rd, 5th, 7th) */
+#define AURA_LATTICE_CHORD_TONES_MAX 4
+typedef struct aura_lattice_chord_shape {
+	int Count;
+	aura_lattice Tones[AURA_LATTICE_CHORD_TONES_MAX];
+} aura_lattice_chord_shape;
+
+/* indexed by aura_chord Kind; all tones within the octave above the root */
+aura_lattice_chord_shape auraLatticeChordShapes[] = {
+	/*               root                3rd (M3/m3/sus)     5th                 7th              */
+	/* Major       */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,0, 1), AURA_LATTICE( 0,1, 0) } },
+	/* Minor       */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,1, 0) } },
+	/* Diminished  */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,2,-2) } },
+	/* Augmented   */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,0, 1), AURA_LATTICE( 0,0, 2) } },
+	/* Major7      */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,0, 1), AURA_LATTICE( 0,1, 0), AURA_LATTICE(0,1, 1) } },
+	/* Minor7      */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,1, 0), AURA_LATTICE(0,2,-1) } },
+	/* 7           */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,0, 1), AURA_LATTICE( 0,1, 0), AURA_LATTICE(0,2,-1) } },
+	/* MinMaj7     */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,1, 0), AURA_LATTICE(0,1, 1) } },
+	/* HalfDim7    */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,2,-2), AURA_LATTICE(0,2,-1) } },
+	/* Diminished7 */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,1,-1), AURA_LATTICE( 0,2,-2), AURA_LATTICE(0,3,-3) } },
+	/* AugMaj7     */ { 4, { AURA_LATTICE(0,0,0), AURA_LATTICE(0,0, 1), AURA_LATTICE( 0,0, 2), AURA_LATTICE(0,1, 1) } },
+	/* Suspended4  */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(1,-1,0), AURA_LATTICE( 0,1, 0) } },
+	/* Suspended2  */ { 3, { AURA_LATTICE(0,0,0), AURA_LATTICE(-1,2,0), AURA_LATTICE( 0,1, 0) } },
+};
+
+aura_lattice
+aura_LatticeAdd(aura_lattice A, aura_lattice B)
+{ return (((A & AURA_LATTICE_LO) + (B & AURA_LATTICE_LO)) ^ ((A ^ B) & AURA_LATTICE_HI)) | ((A | B) & AURA_LATTICE_Error); }
+
+aura_lattice
+aura_LatticeSub(aura_lattice A, aura_lattice B)
+{ return (((A | AURA_LATTICE_HI) - (B & AURA_LATTICE_LO)) ^ ((A ^ ~B) & AURA_LATTICE_HI)) | ((A | B) & AURA_LATTICE_Error); }
+
+aura_lattice aura_LatticeNeg(aura_lattice A) { return aura_LatticeSub(0, A); }
+
+int
+aura_LatticeSemitones(aura_lattice A) {
+	return 12 * AURA_LATTICE_OCTAVES(A) + 7 * AURA_LATTICE_FIFTHS(A) + 4 * AURA_LATTICE_THIRDS(A);
+}
+
+aura_lattice
+aura_LatticeFromNote(aura_note Note) {
+	aura_lattice Result = (Note >= AURA_NOTE_DECORATE(Error) && Note <= AURA_NOTE_DECORATE(Cb))
+		? auraNoteToLattice[Note]
+		: AURA_LATTICE_Error;
+	return Result;
+}
+
+/* Ignores octaves; notes needing double sharps/flats are aura_Error */
+aura_note
+aura_LatticeToNote(aura_lattice A) {
+	int LineOf5ths = AURA_LATTICE_FIFTHS(A) + 4 * AURA_LATTICE_THIRDS(A);
+	aura_note Result = (!(A & AURA_LATTICE_Error)                      &&
+			LineOf5ths >= AURA_LINE_OF_5TH_DECORATE(Min)               &&
+			LineOf5ths <= AURA_LINE_OF_5TH_DECORATE(Max))
+		? auraLineOf5thsToNote[LineOf5ths]
+		: AURA_NOTE_DECORATE(Error);
+	return Result;
+}
+
+/* e.g. for an aura_interval; spelled Db..F# (so m2 not A1, TT as A4) */
+aura_lattice
+aura_LatticeFromSemitones(int Semitones) {
+	int PitchClass = (Semitones % 12 + 12) % 12;
+	int Octaves    = (Semitones - PitchClass) / 12;
+	int LineOf5ths = (7 * PitchClass + 5) % 12 - 5;
+	aura_lattice Result = aura_LatticeAdd(auraLineOf5thsToLattice[LineOf5ths], AURA_LATTICE(Octaves, 0, 0));
+	return Result;
+}
+
+/* Steps (see aura_LatticeDist) between pitches less than an octave apart */
+int auraLatticeStepsInOctave[12] = { 0, 2, 2, 1, 1, 1, 2, 1, 1, 1, 2, 2 };
+
+/* Shortest path between the sounding pitches, where one step is a Tonnetz move
+ * landing in either octave (P5/P4, M3/m6, m3/M6) or an octave (P8), up or down.
+ * Being a shortest path, it's a metric (symmetric, triangle inequality holds).
+ * Different routes to the same pitch are the same point: C + 4*P5 - 2*P8 is 0 from E.
+ *  - within an octave: auraLatticeStepsInOctave, e.g. C4->F4 and C4->A4 are 1, C4->D4 is 2
+ *  - from an octave up: whole octaves, +1 if up to a M6 over, +2 for a m7/M7 over,
+ *    e.g. C4->G4 = G4->D5 = 1 and C4->D5 = 2 (2 fifths)
+ * Returns -1 if either point is AURA_LATTICE_Error. */
+int
+aura_LatticeDist(aura_lattice A, aura_lattice B) {
+	int Semitones = aura_LatticeSemitones(A) - aura_LatticeSemitones(B);
+	int Over, Result = -1;
+	if(Semitones < 0) { Semitones = -Semitones; }
+	Over = Semitones % 12;
+	if(!((A | B) & AURA_LATTICE_Error)) {
+		Result = (Semitones < 12)
+			? auraLatticeStepsInOctave[Semitones]
+			: Semitones / 12 + (Over != 0) + (Over > aura_M6);
+	}
+	return Result;
+}
+
+/* Writes the chord's tones (root, 3rd, 5th[, 7th]) to Tones, which needs room for
+ * AURA_LATTICE_CHORD_TONES_MAX. Inverted tones are moved up an octave.
+ * Returns the number of tones, or 0 for an invalid chord. */
+int
+aura_LatticeFromChord(aura_chord *Chord, aura_lattice *Tones) {
+	int i, Result = 0;
+	aura_lattice Root = aura_LatticeFromNote(Chord->Root);
+	if(Chord->Kind <= AURA_CHORD_Suspended2 && Root != AURA_LATTICE_Error) {
+		Result = auraLatticeChordShapes[Chord->Kind].Count;
+		for(i = 0; i < Result; ++i) {
+			Tones[i] = aura_LatticeAdd(Root, auraLatticeChordShapes[Chord->Kind].Tones[i]);
+			if(i < Chord->Inversion) { Tones[i] = aura_LatticeAdd(Tones[i], AURA_LATTICE(1, 0, 0)); }
+		}
+	}
+	return Result;
+}
+
+/* Identifies the chord whose tones (any order/octave) are exactly Tones[0..Count):
+ * Kind and Root from the spelled intervals, Inversion from the lowest-sounding tone.
+ * Spelling matters: C-E-G# is C augmented, C-E-Ab is Ab augmented.
+ * Where a set fits more than one root (e.g. Csus2 = Gsus4), earlier tones are
+ * tried as the root first, so a root-first order (as from aura_LatticeFromChord) round-trips.
+ * Returns 1 if identified, else 0 (Chord untouched). */
+int
+aura_LatticeToChord(aura_lattice *Tones, int Count, aura_chord *Chord) {
+	int Root, Kind, i, j, Used, Bass = 0, Inversion = 0, Result = 0;
+	for(i = 0; i < Count; ++i) {
+		if(Tones[i] & AURA_LATTICE_Error) { Count = 0; }
+		else if(aura_LatticeSemitones(Tones[i]) < aura_LatticeSemitones(Tones[Bass])) { Bass = i; }
+	}
+	for(Root = 0; Root < Count && !Result; ++Root) {
+		for(Kind = 0; Kind <= AURA_CHORD_Suspended2 && !Result; ++Kind) {
+			aura_lattice_chord_shape *Shape = &auraLatticeChordShapes[Kind];
+			if(Shape->Count != Count) { continue; }
+			/* match each tone to a distinct shape tone, by Fifths/Thirds relative to the root */
+			for(i = 0, Used = 0; i < Count; ++i) {
+				aura_lattice Rel = aura_LatticeSub(Tones[i], Tones[Root]) & 0xffff;
+				for(j = 0; j < Count && ((Used & (1 << j)) || (Shape->Tones[j] & 0xffff) != Rel); ++j) {}
+				if(j == Count) { break; }
+				Used |= 1 << j;
+				if(i == Bass) { Inversion = j; }
+			}
+			if(i == Count && aura_LatticeToNote(Tones[Root]) != AURA_NOTE_DECORATE(Error)) {
+				Chord->Kind      = Kind;
+				Chord->Root      = aura_LatticeToNote(Tones[Root]);
+				Chord->Inversion = Inversion;
+				Result = 1;
+			}
+		}
+	}
+	return Result;
+}
+
+/* BULK ******************************/
+#if !defined(AURA_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AURA_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* NOTE: SSE2 has no byte gather, so this one is just the table lookup */
+void
+aura_LatticeFromNotes(aura_note *Notes, int Count, aura_lattice *Out) {
+	int i;
+	AURA_PROFILE_BEGIN(aura_LatticeFromNotes)
+	for(i = 0; i < Count; ++i) { Out[i] = aura_LatticeFromNote(Notes[i]); }
+	AURA_PROFILE_END(aura_LatticeFromNotes)
+}
+
+void
+aura_LatticeToNotes(aura_lattice *Points, int Count, aura_note *Out) {
+	int i;
+	AURA_PROFILE_BEGIN(aura_LatticeToNotes)
+	for(i = 0; i < Count; ++i) { Out[i] = aura_LatticeToNote(Points[i]); }
+	AURA_PROFILE_END(aura_LatticeToNotes)
+}
+
+/* Chord i's tones go to Tones[i * AURA_LATTICE_CHORD_TONES_MAX...], as aura_LatticeFromChord;
+ * unused slots (triads, invalid chords) are AURA_LATTICE_Error */
+void
+aura_LatticeFromChords(aura_chord *Chords, int Count, aura_lattice *Tones) {
+	int i, j, Written;
+	AURA_PROFILE_BEGIN(aura_LatticeFromChords)
+	for(i = 0; i < Count; ++i, Tones += AURA_LATTICE_CHORD_TONES_MAX) {
+		Written = aura_LatticeFromChord(&Chords[i], Tones);
+		for(j = Written; j < AURA_LATTICE_CHORD_TONES_MAX; ++j) { Tones[j] = AURA_LATTICE_Error; }
+	}
+	AURA_PROFILE_END(aura_LatticeFromChords)
+}
+
+/* Inverse of aura_LatticeFromChords: each chord's tones are the non-error slots of its
+ * AURA_LATTICE_CHORD_TONES_MAX block. Unidentified chords get Root = aura_Error.
+ * Returns the number identified. */
+int
+aura_LatticeToChords(aura_lattice *Tones, int Count, aura_chord *Chords) {
+	int i, ToneCount, Result = 0;
+	AURA_PROFILE_BEGIN(aura_LatticeToChords)
+	for(i = 0; i < Count; ++i, Tones += AURA_LATTICE_CHORD_TONES_MAX) {
+		for(ToneCount = 0; ToneCount < AURA_LATTICE_CHORD_TONES_MAX && !(Tones[ToneCount] & AURA_LATTICE_Error); ++ToneCount) {}
+		if(aura_LatticeToChord(Tones, ToneCount, &Chords[i])) { ++Result; }
+		else                                                  { Chords[i].Root = AURA_NOTE_DECORATE(Error); }
+	}
+	AURA_PROFILE_END(aura_LatticeToChords)
+	return Result;
+}
+
+/* Adds Offset to each point in place (e.g. transposition) */
+void
+aura_LatticeTranslate(aura_lattice *Points, int Count, aura_lattice Offset) {
+	int i = 0;
+	AURA_PROFILE_BEGIN(aura_LatticeTranslate)
+#ifdef AURA_SSE2
+	{
+		__m128i Offset4 = _mm_set1_epi32((int)Offset);
+		__m128i Error4  = _mm_set1_epi32((int)AURA_LATTICE_Error);
+		for(; i + 4 <= Count; i += 4) {
+			__m128i P = _mm_loadu_si128((__m128i *)(Points + i));
+			__m128i Sum = _mm_or_si128(_mm_add_epi8(P, Offset4), _mm_and_si128(_mm_or_si128(P, Offset4), Error4));
+			_mm_storeu_si128((__m128i *)(Points + i), Sum);
+		}
+	}
+#endif/* AURA_SSE2 */
+	for(; i < Count; ++i) { Points[i] = aura_LatticeAdd(Points[i], Offset); }
+	AURA_PROFILE_END(aura_LatticeTranslate)
+}
+
+#ifdef AURA_SSE2
+/* sign-extend one byte of each 32-bit lane */
+#define AURA_SSE2_LATTICE_COORD(v, byte) _mm_srai_epi32(_mm_slli_epi32(v, 24 - 8 * (byte)), 24)
+#define AURA_SSE2_ABS(v, tmp)            (tmp = _mm_srai_epi32(v, 31), _mm_sub_epi32(_mm_xor_si128(v, tmp), tmp))
+/* 12*Octaves + 7*Fifths + 4*Thirds, without SSE4.1's mullo */
+#define AURA_SSE2_LATTICE_SEMITONES(v, o, f, t) \
+	(o = AURA_SSE2_LATTICE_COORD(v, 2), f = AURA_SSE2_LATTICE_COORD(v, 0), t = AURA_SSE2_LATTICE_COORD(v, 1), \
+	 _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(o, 3), _mm_slli_epi32(o, 2)), \
+	               _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(f, 3), f), _mm_slli_epi32(t, 2))))
+#endif/* AURA_SSE2 */
+
+/* Out[i] = aura_LatticeDist(Points[i], From) */
+void
+aura_LatticeDists(aura_lattice *Points, int Count, aura_lattice From, int *Out) {
+	int i = 0;
+	AURA_PROFILE_BEGIN(aura_LatticeDists)
+#ifdef AURA_SSE2
+	{
+		/* no integer divide either: Octaves = |Semitones| / 12 via float, then fix up the remainder */
+		__m128i O, F, T, Tmp;
+		__m128i From4   = _mm_set1_epi32((int)From);
+		__m128i FromS   = AURA_SSE2_LATTICE_SEMITONES(From4, O, F, T);
+		__m128i Twelve  = _mm_set1_epi32(12);
+		__m128i One     = _mm_set1_epi32(1);
+		__m128 OneTwelfth = _mm_set1_ps(1.0f / 12.0f);
+		for(; i + 4 <= Count; i += 4) {
+			__m128i P     = _mm_loadu_si128((__m128i *)(Points + i));
+			__m128i S     = _mm_sub_epi32(AURA_SSE2_LATTICE_SEMITONES(P, O, F, T), FromS);
+			__m128i Octs, Rem, Fix, Steps, Over, Small, Dist;
+			S    = AURA_SSE2_ABS(S, Tmp);
+			Octs = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(S), OneTwelfth));
+			Rem  = _mm_sub_epi32(S, _mm_add_epi32(_mm_slli_epi32(Octs, 3), _mm_slli_epi32(Octs, 2)));
+			Fix  = _mm_cmplt_epi32(Rem, _mm_setzero_si128());            /* -1 where Octs was 1 too many */
+			Octs = _mm_add_epi32(Octs, Fix);
+			Rem  = _mm_add_epi32(Rem, _mm_and_si128(Fix, Twelve));
+			Fix  = _mm_cmpgt_epi32(Rem, _mm_set1_epi32(11));             /* -1 where Octs was 1 too few */
+			Octs = _mm_sub_epi32(Octs, Fix);
+			Rem  = _mm_sub_epi32(Rem, _mm_and_si128(Fix, Twelve));
+
+			/* within an octave, auraLatticeStepsInOctave: 0 for 0; 1 for 3,4,5 and 7,8,9; else 2 */
+			Fix   = _mm_or_si128(
+					_mm_and_si128(_mm_cmpgt_epi32(Rem, _mm_set1_epi32(2)), _mm_cmplt_epi32(Rem, _mm_set1_epi32(6))),
+					_mm_and_si128(_mm_cmpgt_epi32(Rem, _mm_set1_epi32(6)), _mm_cmplt_epi32(Rem, _mm_set1_epi32(10))));
+			Steps = _mm_sub_epi32(_mm_set1_epi32(2), _mm_and_si128(Fix, One));
+			Steps = _mm_andnot_si128(_mm_cmpeq_epi32(Rem, _mm_setzero_si128()), Steps);
+
+			/* from an octave up: Octs + (Rem != 0) + (Rem > M6) */
+			Over  = _mm_add_epi32(_mm_andnot_si128(_mm_cmpeq_epi32(Rem, _mm_setzero_si128()), One),
+			                      _mm_and_si128(_mm_cmpgt_epi32(Rem, _mm_set1_epi32(aura_M6)), One));
+			Over  = _mm_add_epi32(Octs, Over);
+			Small = _mm_cmplt_epi32(S, Twelve);
+			Dist  = _mm_or_si128(_mm_and_si128(Small, Steps), _mm_andnot_si128(Small, Over));
+
+			/* all bits set (-1) where either point is AURA_LATTICE_Error */
+			Dist = _mm_or_si128(Dist, _mm_srai_epi32(_mm_or_si128(P, From4), 31));
+			_mm_storeu_si128((__m128i *)(Out + i), Dist);
+		}
+	}
+#endif/* AURA_SSE2 */
+	for(; i < Count; ++i) { Out[i] = aura_LatticeDist(Points[i], From); }
+	AURA_PROFILE_END(aura_LatticeDists)
+}
+/*************************************/
+
 int aura_KeySharpsCount(aura_circle_of_5ths Key) { return aura_5thDist(Key, AU_5ths_C); }
 
 int aura_KeySharps(aura_circle_of_5ths Key, signature *Sig) {
@@ -707,6 +1516,7 @@ int aura_KeySharps(aura_circle_of_5ths Key, signature *Sig) {
 
 #ifdef AURA_SELFTEST
 #include <stdio.h>
+#include <string.h>
 #include "../sweet/sweet.h"
 
 int main()
@@ -716,6 +1526,238 @@ int main()
 		TestEq(AU_5ths_Count, 12);
 	} EndTestGroup;
 
+	TestGroup("Progression index");
+	{
+#define AURA_TEST_LIBRARY_COUNT 300
+#define AURA_TEST_K 5
+		aura_progression Maj   = { 4, { AU_5ths_C, AU_5ths_A, AU_5ths_F, AU_5ths_G },
+		                              { AURA_CHORD_Major, AURA_CHORD_Major, AURA_CHORD_Major, AURA_CHORD_Major } };
+		aura_progression Min   = { 4, { AU_5ths_C, AU_5ths_A, AU_5ths_F, AU_5ths_G },
+		                              { AURA_CHORD_Major, AURA_CHORD_Minor, AURA_CHORD_Major, AURA_CHORD_Major } };
+		aura_progression MinEb = { 3, { AU_5ths_Eb, AU_5ths_C, AU_5ths_Ab },
+		                              { AURA_CHORD_Major, AURA_CHORD_Minor, AURA_CHORD_Major } };
+		aura_progression Bad   = { 1, { AU_5ths_Count }, { AURA_CHORD_Major } };
+		aura_progression Library[AURA_TEST_LIBRARY_COUNT];
+		/* +1 node covers the header */
+		aura_progression_index_node Built[AURA_TEST_LIBRARY_COUNT + 1], Loaded[AURA_TEST_LIBRARY_COUNT + 1];
+		aura_progression_index Index, Untouched = { 0, 0 };
+		unsigned int Seed = 12345;
+		int i, j, k, Query, Found, Ids[AURA_TEST_K], Dists[AURA_TEST_K], Best[AURA_TEST_K], Mismatches = 0;
+
+		TestEq(aura_ProgressionDist(&Maj, &Min), 1);
+		TestEq(aura_ProgressionDist(&Min, &MinEb), AURA_PROGRESSION_CHORD_DIST_MAX);
+
+		for(i = 0; i < AURA_TEST_LIBRARY_COUNT; ++i) {
+			Library[i].Count = 1 + ((Seed = Seed * 1103515245 + 12345) >> 16) % 6;
+			for(j = 0; j < Library[i].Count; ++j) {
+				Library[i].Chords[j] = ((Seed = Seed * 1103515245 + 12345) >> 16) % AU_5ths_Count;
+				Library[i].Kinds[j]  = ((Seed = Seed * 1103515245 + 12345) >> 16) % 2;
+			}
+		}
+		TestEq(aura_ProgressionIndexBuild(Built, sizeof(Built), Library, AURA_TEST_LIBRARY_COUNT, &Index), 1);
+
+		/* same library, different junk past each Count -> same bytes */
+		for(i = 0; i < AURA_TEST_LIBRARY_COUNT; ++i) {
+			for(j = Library[i].Count; j < AURA_PROGRESSION_MAX; ++j) { Library[i].Chords[j] = Library[i].Kinds[j] = 0xAA; }
+		}
+		memset(Loaded, 0x55, sizeof(Loaded));
+		TestEq(aura_ProgressionIndexBuild(Loaded, sizeof(Loaded), Library, AURA_TEST_LIBRARY_COUNT, &Index), 1);
+		TestEq(memcmp(Loaded, Built, aura_ProgressionIndexSize(AURA_TEST_LIBRARY_COUNT)), 0);
+
+		/* a failed build leaves Memory and Index alone */
+		TestEq(aura_ProgressionIndexBuild(Loaded, sizeof(Loaded), &Bad, 1, &Untouched), 0);
+		TestEq(Untouched.Header == 0, 1);
+		TestEq(memcmp(Loaded, Built, aura_ProgressionIndexSize(AURA_TEST_LIBRARY_COUNT)), 0);
+
+		/* round-trip the block, as if written to a file and mapped back in */
+		memset(Loaded, 0, sizeof(Loaded));
+		memcpy(Loaded, Built, aura_ProgressionIndexSize(AURA_TEST_LIBRARY_COUNT));
+		TestEq(aura_ProgressionIndexOpen(Loaded, sizeof(Loaded), &Index), 1);
+		TestEq(aura_ProgressionIndexValidate(&Index), 1);
+		TestEq(aura_ProgressionIndexOpen(Loaded, aura_ProgressionIndexSize(AURA_TEST_LIBRARY_COUNT) - 1, &Index), 0);
+		TestEq(aura_ProgressionIndexNearest(&Index, &Bad, AURA_TEST_K, Ids, Dists), 0);
+
+		for(Query = 0; Query < 100; ++Query) {
+			aura_progression *Q = &Library[(Query * 7) % AURA_TEST_LIBRARY_COUNT];
+			Q = (Query & 1) ? &MinEb : Q;
+			Found = aura_ProgressionIndexNearest(&Index, Q, AURA_TEST_K, Ids, Dists);
+			Mismatches += (Found != AURA_TEST_K);
+
+			/* brute force: the K smallest distances */
+			for(k = 0; k < AURA_TEST_K; ++k) { Best[k] = AURA_PROGRESSION_DIST_MAX; }
+			for(i = 0; i < AURA_TEST_LIBRARY_COUNT; ++i) {
+				int Dist = aura_ProgressionDist(Q, &Library[i]);
+				for(k = AURA_TEST_K; k > 0 && Best[k - 1] > Dist; --k) {
+					if(k < AURA_TEST_K) { Best[k] = Best[k - 1]; }
+				}
+				if(k < AURA_TEST_K) { Best[k] = Dist; }
+			}
+			for(k = 0; k < Found; ++k) {
+				Mismatches += (Dists[k] != Best[k]);
+				Mismatches += (aura_ProgressionDist(Q, &Library[Ids[k]]) != Dists[k]);
+				for(j = 0; j < k; ++j) { Mismatches += (Ids[j] == Ids[k]); }
+			}
+		}
+		TestEq(Mismatches, 0);
+
+		/* corrupt node: Open stays O(1) and succeeds, Validate catches it, search stays in bounds */
+		Index.Nodes[1].Progression.Count = 200;
+		TestEq(aura_ProgressionIndexOpen(Loaded, sizeof(Loaded), &Index), 1);
+		TestEq(aura_ProgressionIndexValidate(&Index), 0);
+		TestEq(aura_ProgressionIndexNearest(&Index, &MinEb, AURA_TEST_K, Ids, Dists), AURA_TEST_K);
+#undef AURA_TEST_LIBRARY_COUNT
+#undef AURA_TEST_K
+	} EndTestGroup;
+
+	TestGroup("Tonnetz lattice");
+	{
+		aura_note Notes[] = { aura_C, aura_E, aura_G, aura_Bb, aura_Fs };
+		aura_lattice Points[5];
+		aura_note Transposed[5];
+		aura_chord Chord = { AURA_CHORD_Minor, aura_A, 1 };
+		aura_lattice Tones[AURA_LATTICE_CHORD_TONES_MAX];
+		int Dists[5];
+		aura_LatticeFromNotes(Notes, 5, Points);
+		TestEq(aura_LatticeSemitones(Points[3]), aura_m7);
+		aura_LatticeTranslate(Points, 5, aura_LatticeFromSemitones(aura_M3));
+		aura_LatticeToNotes(Points, 5, Transposed);
+		TestEq(Transposed[0], aura_E);
+		TestEq(Transposed[1], aura_Gs);
+		TestEq(Transposed[3], aura_D);
+		TestEq(Transposed[4], aura_As);
+		aura_LatticeDists(Points, 5, Points[0], Dists);
+		TestEq(Dists[1], 1); /* M3 */
+		TestEq(Dists[2], 1); /* P5 */
+		TestEq(Dists[3], 2); /* m7: P5 + m3 */
+		TestEq(Dists[4], 2); /* TT: m3 + m3, from the scalar tail */
+		TestEq(aura_LatticeDist(aura_LatticeFromNote(aura_C), aura_LatticeFromNote(aura_F)), 1);
+		TestEq(aura_LatticeDist(aura_LatticeFromNote(aura_C), aura_LatticeFromNote(aura_A)), 1);
+		TestEq(aura_LatticeDist(aura_LatticeFromNote(aura_C), aura_LatticeFromNote(aura_D)), 2);
+		TestEq(aura_LatticeDist(aura_LatticeFromNote(aura_C), aura_LatticeFromSemitones(aura_P5)), 1);
+		TestEq(aura_LatticeDist(aura_LatticeFromSemitones(aura_P5), aura_LatticeFromSemitones(aura_M2 + aura_P8)), 1);
+		TestEq(aura_LatticeDist(aura_LatticeFromNote(aura_C), aura_LatticeFromSemitones(aura_M2 + aura_P8)), 2);
+		TestEq(aura_LatticeDist(AURA_LATTICE(-2, 4, 0), aura_LatticeFromNote(aura_E)), 0);
+		TestEq(aura_LatticeDist(AURA_LATTICE_Error, aura_LatticeFromNote(aura_E)), -1);
+		{
+			/* it's a metric over pitches: symmetric and the triangle inequality holds */
+			int a, b, c, Violations = 0;
+			for(a = -30; a <= 30; ++a) for(b = -30; b <= 30; ++b) {
+				aura_lattice A = aura_LatticeFromSemitones(a), B = aura_LatticeFromSemitones(b);
+				int AB = aura_LatticeDist(A, B);
+				Violations += (AB != aura_LatticeDist(B, A)) + ((AB == 0) != (a == b));
+				for(c = -30; c <= 30; ++c) {
+					aura_lattice C = aura_LatticeFromSemitones(c);
+					Violations += (aura_LatticeDist(A, C) > AB + aura_LatticeDist(B, C));
+				}
+			}
+			TestEq(Violations, 0);
+		}
+		TestEq(aura_LatticeAdd(AURA_LATTICE_Error, AURA_LATTICE_Error) & AURA_LATTICE_Error, AURA_LATTICE_Error);
+		TestEq(aura_LatticeSub(AURA_LATTICE_Error, AURA_LATTICE_Error) & AURA_LATTICE_Error, AURA_LATTICE_Error);
+		{
+			/* batch paths vs scalar, with a tail (not a multiple of 4), negatives and an error point */
+			aura_lattice Batch[7] = {
+				AURA_LATTICE(0, 0, 0),   AURA_LATTICE(-3, 5, -7), AURA_LATTICE(2, -9, 4),
+				AURA_LATTICE_Error,      AURA_LATTICE(-1, -1, -1), AURA_LATTICE(5, 11, 3),
+				AURA_LATTICE(-6, 0, -5),
+			};
+			aura_lattice Original[7], From = AURA_LATTICE(1, -2, 3);
+			int BatchDists[7], i, Mismatches = 0;
+			aura_LatticeDists(Batch, 7, From, BatchDists);
+			for(i = 0; i < 7; ++i) {
+				Mismatches += (BatchDists[i] != aura_LatticeDist(Batch[i], From));
+				Original[i] = Batch[i];
+			}
+			aura_LatticeTranslate(Batch, 7, From);
+			for(i = 0; i < 7; ++i) { Mismatches += (Batch[i] != aura_LatticeAdd(Original[i], From)); }
+			TestEq(Mismatches, 0);
+			TestEq(BatchDists[3], -1);
+			TestEq(Batch[3] & AURA_LATTICE_Error, AURA_LATTICE_Error);
+
+			/* Error + Error in the SSE2 lanes too */
+			for(i = 0; i < 7; ++i) { Batch[i] = AURA_LATTICE_Error; }
+			aura_LatticeTranslate(Batch, 7, AURA_LATTICE_Error);
+			for(i = 0; i < 7; ++i) { Mismatches += !(Batch[i] & AURA_LATTICE_Error); }
+			TestEq(Mismatches, 0);
+		}
+		TestEq(aura_LatticeFromChord(&Chord, Tones), 3);
+		TestEq(aura_LatticeToNote(Tones[1]), aura_C);
+		TestEq(aura_LatticeSemitones(Tones[0]) - aura_LatticeSemitones(Tones[2]), aura_P4);
+		{
+			/* every root/kind/inversion round-trips through the bulk chord paths */
+			aura_chord Chords[21 * 13 * 4], Identified[21 * 13 * 4];
+			aura_lattice ChordTones[21 * 13 * 4 * AURA_LATTICE_CHORD_TONES_MAX];
+			aura_lattice Shuffled[3];
+			int Root, Kind, Inversion, Count = 0, i, Mismatches = 0;
+			for(Root = aura_C; Root <= aura_Cb; ++Root) {
+				for(Kind = 0; Kind <= AURA_CHORD_Suspended2; ++Kind) {
+					for(Inversion = 0; Inversion < auraLatticeChordShapes[Kind].Count; ++Inversion, ++Count) {
+						Chords[Count].Kind      = Kind;
+						Chords[Count].Root      = Root;
+						Chords[Count].Inversion = Inversion;
+					}
+				}
+			}
+			aura_LatticeFromChords(Chords, Count, ChordTones);
+			TestEq(aura_LatticeToChords(ChordTones, Count, Identified), Count);
+			for(i = 0; i < Count; ++i) {
+				Mismatches += (Identified[i].Kind      != Chords[i].Kind ||
+				               Identified[i].Root      != Chords[i].Root ||
+				               Identified[i].Inversion != Chords[i].Inversion);
+			}
+			TestEq(Mismatches, 0);
+
+			/* any order: Am/C given as E, C, A */
+			Shuffled[0] = Tones[2]; Shuffled[1] = Tones[1]; Shuffled[2] = Tones[0];
+			TestEq(aura_LatticeToChord(Shuffled, 3, &Identified[0]), 1);
+			TestEq(Identified[0].Kind, AURA_CHORD_Minor);
+			TestEq(Identified[0].Root, aura_A);
+			TestEq(Identified[0].Inversion, 1);
+			/* spelling matters: C-E-Ab is Ab augmented, C-D-E isn't a chord */
+			Shuffled[0] = aura_LatticeFromNote(aura_C);
+			Shuffled[1] = aura_LatticeFromNote(aura_E);
+			Shuffled[2] = aura_LatticeFromNote(aura_Ab);
+			TestEq(aura_LatticeToChord(Shuffled, 3, &Identified[0]), 1);
+			TestEq(Identified[0].Kind, AURA_CHORD_Augmented);
+			TestEq(Identified[0].Root, aura_Ab);
+			Shuffled[2] = aura_LatticeFromNote(aura_D);
+			TestEq(aura_LatticeToChord(Shuffled, 3, &Identified[0]), 0);
+		}
+	} EndTestGroup;
+
+#ifdef AURA_PROFILE
+	TestGroup("Profiling");
+	{
+		aura_ProfileReset();
+		aura_RNADiatonicChord(AU_5ths_C, 4, AURA_KEY_Major);
+		TestEq(auraProfileCounters[AURA_PROF_aura_RNADiatonicChord].Calls, 1);
+		TestEq(auraProfileCounters[AURA_PROF_aura_5thsOffset].Calls, 1);
+		TestEq(auraProfileCounters[AURA_PROF_auraNote].Calls, 0);
+		{
+			aura_profile_counter Total[AURA_PROF_Count] = {{0}};
+			char Line[128], Name[64];
+			unsigned long long Calls, Cycles;
+			FILE *Dump = tmpfile();
+			aura_ProfileAccumulate(Total);
+			aura_ProfileAccumulate(Total);
+			TestEq(Total[AURA_PROF_aura_5thsOffset].Calls, 2);
+
+			aura_ProfileDump(Dump, Total);
+			rewind(Dump);
+			TestEq(fgets(Line, sizeof(Line), Dump) != 0, 1);
+			TestEq(strcmp(Line, "function,calls,cycles\n"), 0);
+			TestEq(fgets(Line, sizeof(Line), Dump) != 0, 1);
+			TestEq(sscanf(Line, "%63[^,],%llu,%llu", Name, &Calls, &Cycles), 3);
+			TestEq(strcmp(Name, "auraNote"), 0);
+			TestEq(fgets(Line, sizeof(Line), Dump) != 0, 1);
+			TestEq(sscanf(Line, "%63[^,],%llu,%llu", Name, &Calls, &Cycles), 3);
+			TestEq(strcmp(Name, "aura_5thsOffset"), 0);
+			TestEq(Calls, 2);
+			fclose(Dump);
+		}
+	} EndTestGroup;
+#endif/*AURA_PROFILE*/
+
 	return 0;
 }
 #endif/*AURA_SELFTEST*/